@@ -0,0 +1,81 @@
+#include "arena.h"
+
+//--------------------------------------------------------------
+// Constants
+//--------------------------------------------------------------
+
+namespace {
+    
+    const size_t CAPACITY_DEFAULT = 1 << 16;
+    
+}
+
+
+//--------------------------------------------------------------
+// Public class constructors & destructor
+//--------------------------------------------------------------
+
+arena::arena():
+    arena(CAPACITY_DEFAULT)
+{}
+
+arena::arena( const size_t &capacity ):
+    block(new char[capacity]),
+    capacity(capacity),
+    used(0),
+    overflowUsed(0),
+    highWater(0),
+    overflows(0)
+{}
+
+arena::~arena(){
+    
+    for ( unsigned int i = 0; i < overflow.size(); i++ ){ delete[] overflow[i]; }
+    delete[] block;
+    
+}
+
+
+//--------------------------------------------------------------
+// Public member functions
+//--------------------------------------------------------------
+
+// Allocate memory with the given alignment, valid until the next reset.
+// Alignment must be a power of two no larger than that of std::max_align_t.
+//
+void* arena::allocate( const size_t &bytes, const size_t &alignment ){
+    
+    size_t start = ( used + alignment - 1 ) & ~( alignment - 1 );
+    
+    if ( start + bytes <= capacity ){
+        used = start + bytes;
+        highWater = max( highWater, used + overflowUsed );
+        return block + start;
+    }
+    
+    char* extra = new char[bytes];
+    overflow.push_back(extra);
+    overflowUsed += bytes + alignment;
+    highWater = max( highWater, used + overflowUsed );
+    ++overflows;
+    return extra;
+    
+}
+
+// Release all memory handed out since the last reset.
+// If some requests overflowed, grow the block to fit the high-water mark.
+//
+void arena::reset(){
+    
+    if ( !overflow.empty() ){
+        for ( unsigned int i = 0; i < overflow.size(); i++ ){ delete[] overflow[i]; }
+        overflow.clear();
+        delete[] block;
+        capacity = max( 2 * capacity, highWater );
+        block = new char[capacity];
+    }
+    
+    used = 0;
+    overflowUsed = 0;
+    
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "ofMain.h"
+
+//========================================================================
+// Arena class
+//========================================================================
+//
+// A frame-scoped bump allocator for transient buffers.
+// Memory is handed out linearly from one block and released all at once
+// by reset(). Requests that do not fit are served from overflow blocks,
+// after which the next reset() grows the main block to the high-water mark,
+// such that steady-state frames do not allocate at all.
+// An arena is not thread-safe; each thread should own its own.
+//
+class arena {
+    
+public:
+    
+    //--------------------------------------------------------------
+    // Public class constructors & destructor
+    //--------------------------------------------------------------
+    
+    arena();
+    arena( const size_t &capacity );
+    arena( const arena &other ) = delete;
+    arena& operator=( const arena &other ) = delete;
+    ~arena();
+    
+    
+    //--------------------------------------------------------------
+    // Public member functions
+    //--------------------------------------------------------------
+    
+    void* allocate( const size_t &bytes, const size_t &alignment );
+    void reset();
+    
+    size_t getCapacity(){ return capacity; }
+    size_t getUsed(){ return used + overflowUsed; }
+    size_t getHighWater(){ return highWater; }
+    int getOverflows(){ return overflows; }
+    
+    
+private:
+    
+    //--------------------------------------------------------------
+    // Private member variables
+    //--------------------------------------------------------------
+    
+    char* block;
+    size_t capacity;
+    size_t used;
+    
+    vector <char*> overflow;
+    size_t overflowUsed;
+    
+    size_t highWater;
+    int overflows;
+    
+};
+
+//========================================================================
+// Arena allocator class
+//========================================================================
+//
+// A standard allocator drawing from an arena, so that containers can use it.
+// Deallocation is a no-op; memory returns to the arena on reset().
+//
+template <class T>
+class arenaAllocator {
+    
+public:
+    
+    typedef T value_type;
+    
+    arena* source;
+    
+    arenaAllocator( arena &source_ ): source(&source_) {}
+    template <class U> arenaAllocator( const arenaAllocator<U> &other ): source(other.source) {}
+    
+    T* allocate( size_t n ){ return static_cast<T*>( source->allocate( n * sizeof(T), alignof(T) ) ); }
+    void deallocate( T* p, size_t n ) {}
+    
+    template <class U> bool operator==( const arenaAllocator<U> &other ) const { return source == other.source; }
+    template <class U> bool operator!=( const arenaAllocator<U> &other ) const { return source != other.source; }
+    
+};
+
+template <class T>
+using arenaVector = std::vector<T, arenaAllocator<T>>;
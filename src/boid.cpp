@@ -1,4 +1,5 @@
 #include "boid.h"
+#include "scene.h"
 
 //--------------------------------------------------------------
 // Constants
@@ -7,7 +8,6 @@
 namespace {
 
     const double V_0 = 0.05;
-    const double SIZE = 0.05;
     const int RESOLUTION = 4;
 
 }
@@ -93,7 +93,7 @@ static ofVec3f randomInSphere( const double &radius ){
 //
 boid::boid(){
     
-    size = SIZE;
+    size = scene::BOID_SIZE;
     randomize();
     
 }
@@ -141,11 +141,12 @@ void boid::randomize( const double &edgeLength_ ){
     
 }
 
-// Update the position with one step of the velocity.
+// Update the position with one of nSteps equal fractions of a step of the velocity.
 //
-void boid::update(){
+void boid::update( const int &nSteps ){
     
-    setPosition( position + velocity );
+    if ( nSteps > 1 ){ setPosition( position + velocity / nSteps ); }
+    else { setPosition( position + velocity ); }
     
 }
 
@@ -71,7 +71,8 @@ public:
     
     void randomize( const double &edgeLength );
     void randomize() { randomize(edgeLength); }
-    void update();
+    void update( const int &nSteps );
+    void update() { update(1); }
     void draw();
     
 };
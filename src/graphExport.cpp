@@ -0,0 +1,256 @@
+#include "graphExport.h"
+#include <limits>
+
+//--------------------------------------------------------------
+// Constants
+//--------------------------------------------------------------
+
+namespace {
+    
+    const char MAGIC[4] = { 'F', 'L', 'K', 'G' };
+    const uint64_t VERSION = 1;
+    const unsigned int SNAPSHOT_INTERVAL = 64; // changes of a boid between snapshots
+    
+}
+
+
+//--------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------
+
+// Append an unsigned integer as a varint.
+//
+static void putVarint( std::string &out, uint64_t value ){
+    
+    while ( value >= 0x80 ){
+        out.push_back( char( ( value & 0x7f ) | 0x80 ) );
+        value >>= 7;
+    }
+    out.push_back( char(value) );
+    
+}
+
+// Read a varint, advancing the position. Return false past the end.
+//
+static bool getVarint( const std::string &in, size_t &pos, uint64_t &value ){
+    
+    value = 0;
+    for ( int shift = 0; pos < in.size() && shift < 64; shift += 7 ){
+        unsigned char byte = in[pos++];
+        value |= uint64_t( byte & 0x7f ) << shift;
+        if ( !( byte & 0x80 ) ){ return true; }
+    }
+    return false;
+    
+}
+
+
+//--------------------------------------------------------------
+// Graph writer: public class constructor & destructor
+//--------------------------------------------------------------
+
+graphWriter::graphWriter():
+    numBoids(0),
+    lastFrame(0),
+    numChanges(0),
+    lastKey(0)
+{}
+
+graphWriter::~graphWriter(){
+    
+    close();
+    
+}
+
+
+//--------------------------------------------------------------
+// Graph writer: public member functions
+//--------------------------------------------------------------
+
+// Create the file and write its header.
+//
+bool graphWriter::open( const std::string &path, const int &numBoids_, const int &maxNeighbours ){
+    
+    close();
+    file.open( path, std::ios::binary | std::ios::trunc );
+    if ( !file.is_open() ){ return false; }
+    
+    numBoids = numBoids_;
+    lastFrame = 0;
+    current.assign( numBoids, vector<edge>() );
+    previous.assign( numBoids, vector<edge>() );
+    for ( int i = 0; i < numBoids; i++ ){
+        current[i].reserve(maxNeighbours);
+        previous[i].reserve(maxNeighbours);
+    }
+    
+    record.clear();
+    record.append( MAGIC, sizeof(MAGIC) );
+    putVarint( record, VERSION );
+    putVarint( record, numBoids );
+    file.write( record.data(), record.size() );
+    return file.good();
+    
+}
+
+// Flush and close the file.
+//
+void graphWriter::close(){
+    
+    if ( file.is_open() ){ file.close(); }
+    
+}
+
+// Add an edge to the graph of the current frame.
+//
+void graphWriter::addEdge( const int &boid, const int &neighbour, const edge::zone &tag ){
+    
+    current[boid].push_back( edge{ neighbour, tag } );
+    
+}
+
+// Write the changes of the current frame since the previous one.
+//
+void graphWriter::endFrame( const int &frame ){
+    
+    if ( !file.is_open() ){ return; }
+    
+    changes.clear();
+    numChanges = 0;
+    lastKey = 0;
+    
+    for ( int i = 0; i < numBoids; i++ ){
+        vector<edge> &now = current[i];
+        vector<edge> &before = previous[i];
+        sort( now.begin(), now.end(), []( const edge &a, const edge &b ){ return a.neighbour < b.neighbour; } );
+        
+        unsigned int p = 0, q = 0;
+        while ( p < now.size() || q < before.size() ){
+            if ( q == before.size() || ( p < now.size() && now[p].neighbour < before[q].neighbour ) ){
+                writeChange( i, now[p].neighbour, now[p].tag );
+                ++p;
+            }
+            else if ( p == now.size() || before[q].neighbour < now[p].neighbour ){
+                writeChange( i, before[q].neighbour, edge::NONE );
+                ++q;
+            }
+            else {
+                if ( now[p].tag != before[q].tag ){ writeChange( i, now[p].neighbour, now[p].tag ); }
+                ++p;
+                ++q;
+            }
+        }
+        
+        now.swap(before);
+        now.clear();
+    }
+    
+    if ( numChanges == 0 ){ return; }
+    
+    record.clear();
+    putVarint( record, frame - lastFrame );
+    putVarint( record, numChanges );
+    file.write( record.data(), record.size() );
+    file.write( changes.data(), changes.size() );
+    lastFrame = frame;
+    
+}
+
+
+//--------------------------------------------------------------
+// Graph writer: private member functions
+//--------------------------------------------------------------
+
+// Append one change, keyed relative to the previous one.
+//
+void graphWriter::writeChange( const int &boid, const int &neighbour, const edge::zone &tag ){
+    
+    uint64_t key = uint64_t(boid) * numBoids + neighbour;
+    putVarint( changes, ( ( key - lastKey ) << 2 ) | tag );
+    lastKey = key;
+    ++numChanges;
+    
+}
+
+
+//--------------------------------------------------------------
+// Graph reader: public member functions
+//--------------------------------------------------------------
+
+// Apply one change to a set of edges.
+//
+void graphReader::applyChange( vector <edge> &edges, const edgeChange &change ){
+    
+    auto it = find_if( edges.begin(), edges.end(),
+                      [&change]( const edge &e ){ return e.neighbour == change.neighbour; } );
+    if ( change.tag == edge::NONE ){ if ( it != edges.end() ){ edges.erase(it); } }
+    else if ( it != edges.end() ){ it->tag = change.tag; }
+    else { edges.push_back( edge{ change.neighbour, change.tag } ); }
+    
+}
+
+// Load a file, index its changes by boid, and take snapshots of the edges.
+//
+bool graphReader::open( const std::string &path ){
+    
+    history.clear();
+    snapshots.clear();
+    lastFrame = 0;
+    
+    std::ifstream file( path, std::ios::binary );
+    if ( !file.is_open() ){ return false; }
+    std::string in( ( std::istreambuf_iterator<char>(file) ), std::istreambuf_iterator<char>() );
+    
+    size_t pos = sizeof(MAGIC);
+    uint64_t version, numBoids;
+    if ( in.compare( 0, sizeof(MAGIC), MAGIC, sizeof(MAGIC) ) != 0 ){ return false; }
+    if ( !getVarint( in, pos, version ) || version != VERSION ){ return false; }
+    if ( !getVarint( in, pos, numBoids ) || numBoids == 0 ){ return false; }
+    if ( numBoids > uint64_t( std::numeric_limits<int>::max() ) ){ return false; }
+    history.assign( numBoids, vector<edgeChange>() );
+    
+    uint64_t frameDelta, numChanges, value;
+    while ( getVarint( in, pos, frameDelta ) && getVarint( in, pos, numChanges ) ){
+        lastFrame += frameDelta;
+        uint64_t key = 0;
+        
+        for ( uint64_t k = 0; k < numChanges; k++ ){
+            if ( !getVarint( in, pos, value ) ){ return false; }
+            key += value >> 2;
+            if ( key / numBoids >= numBoids ){ return false; }
+            history[key / numBoids].push_back( edgeChange{ lastFrame, int( key % numBoids ), edge::zone( value & 3 ) } );
+        }
+    }
+    
+    if ( pos != in.size() ){ return false; }
+    
+    snapshots.assign( numBoids, vector<vector<edge>>() );
+    for ( uint64_t i = 0; i < numBoids; i++ ){
+        vector<edge> edges;
+        for ( unsigned int k = 0; k < history[i].size(); k++ ){
+            if ( k % SNAPSHOT_INTERVAL == 0 ){ snapshots[i].push_back(edges); }
+            applyChange( edges, history[i][k] );
+        }
+    }
+    
+    return true;
+    
+}
+
+// Rebuild the edges of a boid at a given frame from its nearest snapshot.
+//
+vector <edge> graphReader::getNeighbourhood( const int &boid, const int &frame ){
+    
+    const vector<edgeChange> &changes = history.at(boid);
+    auto end = upper_bound( changes.begin(), changes.end(), frame,
+                           []( const int &f, const edgeChange &c ){ return f < c.frame; } );
+    unsigned int numApplied = end - changes.begin();
+    if ( numApplied == 0 ){ return vector<edge>(); }
+    
+    unsigned int s = ( numApplied - 1 ) / SNAPSHOT_INTERVAL;
+    vector<edge> edges = snapshots[boid][s];
+    for ( unsigned int k = s * SNAPSHOT_INTERVAL; k < numApplied; k++ ){ applyChange( edges, changes[k] ); }
+    
+    return edges;
+    
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include "ofMain.h"
+#include <fstream>
+
+//========================================================================
+// Interaction graph export
+//========================================================================
+//
+// The interaction graph of a frame links each boid to its interacting
+// neighbours, tagged with the zone of the cohesion force between them.
+// Graphs are streamed to a binary file as deltas: only edges that appear,
+// disappear, or change zone since the previous frame are written.
+//
+// File layout, where every integer is an unsigned LEB128 varint:
+//   header: "FLKG", version, number of boids
+//   frame:  frame delta, number of changes, changes
+//   change: ( key delta << 2 ) | zone, with key = boid * number of boids + neighbour
+// Changes within a frame are sorted by key and a zone of edge::NONE removes an edge.
+//
+
+//========================================================================
+// Edge class
+//========================================================================
+//
+// An edge from a boid to one of its interacting neighbours.
+//
+class edge {
+    
+public:
+    
+    // Zone of the cohesion force, matching the colour of the line drawn.
+    //
+    enum zone { NONE = 0, REPULSION = 1, EQUILIBRIUM = 2, ATTRACTION = 3 };
+    
+    int neighbour;
+    zone tag;
+    
+};
+
+//========================================================================
+// Edge change class
+//========================================================================
+//
+// A change of the edge from a boid to a neighbour at a given frame.
+//
+class edgeChange {
+    
+public:
+    int frame;
+    int neighbour;
+    edge::zone tag;
+    
+};
+
+//========================================================================
+// Graph writer class
+//========================================================================
+//
+class graphWriter {
+    
+public:
+    
+    //--------------------------------------------------------------
+    // Public class constructor & destructor
+    //--------------------------------------------------------------
+    
+    graphWriter();
+    ~graphWriter();
+    
+    
+    //--------------------------------------------------------------
+    // Public member functions
+    //--------------------------------------------------------------
+    
+    bool open( const std::string &path, const int &numBoids, const int &maxNeighbours );
+    void close();
+    
+    bool isOpen(){ return file.is_open(); }
+    
+    void addEdge( const int &boid, const int &neighbour, const edge::zone &tag );
+    void endFrame( const int &frame );
+    
+    
+private:
+    
+    //--------------------------------------------------------------
+    // Private member variables
+    //--------------------------------------------------------------
+    
+    std::ofstream file;
+    int numBoids;
+    int lastFrame;
+    
+    vector <vector <edge>> current;
+    vector <vector <edge>> previous;
+    
+    std::string record;
+    std::string changes;
+    int numChanges;
+    uint64_t lastKey;
+    
+    
+    //--------------------------------------------------------------
+    // Private member functions
+    //--------------------------------------------------------------
+    
+    void writeChange( const int &boid, const int &neighbour, const edge::zone &tag );
+    
+};
+
+//========================================================================
+// Graph reader class
+//========================================================================
+//
+// Loads a recorded file and indexes the changes by boid. A snapshot of each
+// boid's edges is kept every SNAPSHOT_INTERVAL of its changes, such that a
+// neighbourhood query binary-searches the history by frame and replays at most
+// SNAPSHOT_INTERVAL changes from the nearest snapshot, whatever the run length.
+//
+class graphReader {
+    
+public:
+    
+    //--------------------------------------------------------------
+    // Public member functions
+    //--------------------------------------------------------------
+    
+    static void applyChange( vector <edge> &edges, const edgeChange &change );
+    
+    bool open( const std::string &path );
+    
+    int getNumBoids(){ return history.size(); }
+    int getLastFrame(){ return lastFrame; }
+    
+    const vector <edgeChange>& getHistory( const int &boid ){ return history.at(boid); }
+    vector <edge> getNeighbourhood( const int &boid, const int &frame );
+    
+    
+private:
+    
+    //--------------------------------------------------------------
+    // Private member variables
+    //--------------------------------------------------------------
+    
+    vector <vector <edgeChange>> history;
+    vector <vector <vector <edge>>> snapshots;
+    int lastFrame;
+    
+};
@@ -1,5 +1,9 @@
 #include "ofMain.h"
 #include "ofApp.h"
+#include "ofAppNoWindow.h"
+#include "offlineRenderer.h"
+#include <sys/wait.h>
+#include <unistd.h>
 
 //========================================================================
 // Flocking Simulation
@@ -13,14 +17,79 @@
 //
 // Additionally, the user can change the interaction range and noise strength while the simulation is running.
 //
+// A recorded run can be rendered offline, without a visible window, with
+//   flocking-sim --render <file>.traj [--keyframes <file>] [--jobs <number of worker processes>]
+//
+// The neighbour and velocity phases can be benchmarked without a window, e.g. to compare reordering intervals, with
+//   flocking-sim --benchmark <number of frames> [--reorder <interval>]
+//
 // For more information, visit https://github.com/ebolduc37/flocking-sim .
 
 
 
 //========================================================================
-int main( )
+int main( int argc, char *argv[] )
 {
 
+    std::string renderPath = "";
+    std::string keyframePath = "";
+    int numWorkers = 1;
+    int benchmarkFrames = 0;
+    int benchmarkReorder = -1;
+    
+    for ( int i = 1; i + 1 < argc; i += 2 ){
+        std::string option = argv[i];
+        if ( option == "--render" ){ renderPath = argv[i+1]; }
+        else if ( option == "--keyframes" ){ keyframePath = argv[i+1]; }
+        else if ( option == "--jobs" ){ numWorkers = max( 1, atoi(argv[i+1]) ); }
+        else if ( option == "--benchmark" ){ benchmarkFrames = max( 0, atoi(argv[i+1]) ); }
+        else if ( option == "--reorder" ){ benchmarkReorder = max( 0, atoi(argv[i+1]) ); }
+    }
+    
+    if ( benchmarkFrames > 0 ){
+        ofSetupOpenGL( std::make_shared<ofAppNoWindow>(), 1, 1, OF_WINDOW );
+        ofRunApp(new ofApp( benchmarkFrames, benchmarkReorder ));
+        return 0;
+    }
+    
+    if ( renderPath != "" ){
+        renderPath = ofFilePath::getAbsolutePath( renderPath, false );
+        if ( keyframePath != "" ){ keyframePath = ofFilePath::getAbsolutePath( keyframePath, false ); }
+        
+        // Each child renders one slot of frames. Should a fork fail, the
+        // parent renders the slots that were left without a worker.
+        vector <int> slots = { 0 };
+        bool isChild = false;
+        for ( int k = 1; k < numWorkers && !isChild; k++ ){
+            pid_t pid = fork();
+            if ( pid == 0 ){ slots = { k }; isChild = true; }
+            else if ( pid < 0 ){
+                ofLogError("main") << "could not start worker " << k << ", rendering its frames in the main process";
+                for ( ; k < numWorkers; k++ ){ slots.push_back(k); }
+            }
+        }
+        
+        ofGLFWWindowSettings settings;
+        settings.setSize( 64, 64 );
+        settings.visible = false;
+        ofCreateWindow(settings);
+        std::shared_ptr<offlineRenderer> renderer = std::make_shared<offlineRenderer>( renderPath, keyframePath, slots, numWorkers );
+        ofRunApp(renderer);
+        
+        bool failed = renderer->hasFailed();
+        if ( !isChild ){
+            int status;
+            pid_t pid;
+            while ( ( pid = wait(&status) ) > 0 ){
+                if ( !WIFEXITED(status) || WEXITSTATUS(status) != 0 ){
+                    ofLogError("main") << "worker process " << pid << " failed";
+                    failed = true;
+                }
+            }
+        }
+        return failed ? 1 : 0;
+    }
+
     int windowSize[2] = { 1920/2, 1080/2 };
     //int windowSize[2] = { 1080/2, 1920/2 };
     
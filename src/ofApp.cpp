@@ -1,4 +1,10 @@
 #include "ofApp.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 //--------------------------------------------------------------
 // Setup parameters
@@ -10,6 +16,9 @@ namespace {
 //
 const int NUM_BOIDS = 512; // total number of boids
 const double LENGTH = 10.0; // edge length of the periodic cube
+const ofApp::integrator INTEGRATOR = ofApp::EULER; // time integration scheme
+const int SUB_STEPS = 8; // sub-steps per frame under hard-core repulsion
+const int REORDER_INTERVAL = 0; // frames between spatial reorderings (0 to disable)
 
 // Visualization variables
 //
@@ -25,6 +34,17 @@ const bool SAVE = false; // save frames or not
 const int TIME = 45; // time limit for application to run and save
 const std::string FILE_NAME = "flocking-sim"; // file name prefix
 std::string DIR = "demo";
+const bool SAVE_GRAPH = false; // save interaction graphs or not
+const bool SAVE_TRAJECTORY = false; // save trajectories for offline rendering or not
+
+// Telemetry variables
+//
+const bool TELEMETRY = false; // serve metrics on a local endpoint or not
+const int TELEMETRY_PORT = 9090; // local port of the endpoint
+
+// Benchmark variables
+//
+const int BENCHMARK_SEED = 37; // random seed, such that runs start identically
 
 }
 
@@ -56,18 +76,144 @@ const double LENGTH_RANDOMIZE = R_E * std::cbrt(NUM_BOIDS);
 // Static function
 //--------------------------------------------------------------
 
-// Find indices of the n smallest elements of a vector.
+// Find indices of the n smallest elements of an array.
+// The indices are written at the front of ind, which must hold one per element.
 //
-static vector<int> findSmallestIndices( vector<double> &vec, const int &n ){
+static void findSmallestIndices( const double *vec, arenaVector<int> &ind, const int &n ){
     
-    vector<int> ind(vec.size());
     iota( ind.begin(), ind.end(), 0 );
     partial_sort( ind.begin(), ind.begin() + n, ind.end(),
-                 [&vec]( int i, int j ){ return vec[i] < vec[j]; } );
-    return vector<int>( ind.begin(), ind.begin() + n );
+                 [vec]( int i, int j ){ return vec[i] < vec[j]; } );
+    
+}
+
+// Find the shortest displacement between two points within the periodic cube.
+// Periodic images are only considered when both points are near opposite faces.
+//
+static ofVec3f periodicDisplacement( const ofVec3f &from, const ofVec3f &to ){
+    
+    const ofVec3f r = to - from;
+    ofVec3f r_period = r;
+    const double SAFE_DIST = 0.5 * LENGTH - R_0;
+    
+    for ( int sx = -1; sx <= 1; sx++ ){
+        bool nearBoundary = sx * from.x > SAFE_DIST;
+        if ( sx != 0 && !nearBoundary ) continue;
+        bool nearBoundaryOpp = sx * to.x < -SAFE_DIST;
+        if ( sx != 0 && !nearBoundaryOpp ) continue;
+        
+        for ( int sy = -1; sy <= 1; sy++ ){
+            bool nearBoundary = sy * from.y > SAFE_DIST;
+            if ( sy != 0 && !nearBoundary ) continue;
+            bool nearBoundaryOpp = sy * to.y < -SAFE_DIST;
+            if ( sy != 0 && !nearBoundaryOpp ) continue;
+            
+            for ( int sz = -1; sz <= 1; sz++ ){
+                bool nearBoundary = sz * from.z > SAFE_DIST;
+                if ( sz != 0 && !nearBoundary ) continue;
+                bool nearBoundaryOpp = sz * to.z < -SAFE_DIST;
+                if ( sz != 0 && !nearBoundaryOpp ) continue;
+                
+                ofVec3f r_shift = r + LENGTH * ofVec3f( sx, sy, sz );
+                if ( r_shift.length() < r_period.length() ){ r_period = r_shift; }
+            }
+        }
+    }
+    
+    return r_period;
+    
+}
+
+// Spread the lower 10 bits of an integer such that two zeros separate each bit.
+//
+static uint32_t spreadBits( uint32_t x ){
+    
+    x &= 0x3ff;
+    x = ( x | ( x << 16 ) ) & 0x30000ff;
+    x = ( x | ( x << 8 ) ) & 0x300f00f;
+    x = ( x | ( x << 4 ) ) & 0x30c30c3;
+    x = ( x | ( x << 2 ) ) & 0x9249249;
+    return x;
+    
+}
+
+// Find the Morton key of a position within the periodic cube,
+// such that nearby positions tend to have nearby keys.
+//
+static uint32_t mortonKey( const ofVec3f &position ){
+    
+    const double scale = 1023 / LENGTH;
+    uint32_t x = ofClamp( ( position.x + 0.5 * LENGTH ) * scale, 0, 1023 );
+    uint32_t y = ofClamp( ( position.y + 0.5 * LENGTH ) * scale, 0, 1023 );
+    uint32_t z = ofClamp( ( position.z + 0.5 * LENGTH ) * scale, 0, 1023 );
+    return spreadBits(x) | ( spreadBits(y) << 1 ) | ( spreadBits(z) << 2 );
+    
+}
+
+// Open a counter of the cache misses of this process, disabled until enabled.
+// Return -1 if hardware counters are unavailable, e.g. outside Linux or in a VM.
+//
+static int openCacheMissCounter(){
+    
+#ifdef __linux__
+    perf_event_attr attr = {};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 );
+#else
+    return -1;
+#endif
+    
+}
+
+// Enable or disable a counter opened by openCacheMissCounter.
+//
+static void enableCounter( const int &fd, const bool &enable ){
+    
+#ifdef __linux__
+    if ( fd >= 0 ){ ioctl( fd, enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0 ); }
+#endif
+    
+}
+
+// Read the total of a counter opened by openCacheMissCounter.
+//
+static long long readCounter( const int &fd ){
+    
+    long long count = 0;
+#ifdef __linux__
+    if ( fd >= 0 && read( fd, &count, sizeof(count) ) != sizeof(count) ){ count = 0; }
+#endif
+    return count;
     
 }
 
+//--------------------------------------------------------------
+// Public class constructors
+//--------------------------------------------------------------
+
+// Default ofApp class constructor, for the interactive simulation.
+//
+ofApp::ofApp():
+    ofApp( 0, -1 )
+{}
+
+// ofApp class constructor for a benchmark of benchmarkFrames frames,
+// reordering every benchmarkReorder frames if it is not negative.
+//
+ofApp::ofApp( const int &benchmarkFrames, const int &benchmarkReorder ):
+    benchmarkFrames(benchmarkFrames),
+    benchmarkReorder(benchmarkReorder),
+    benchmarkTime{ 0, 0, 0 },
+    missCounter(-1),
+    misses(0)
+{}
+
+
 //--------------------------------------------------------------
 // Public member functions
 //--------------------------------------------------------------
@@ -80,18 +226,141 @@ void ofApp::randomizeBoids( const double &edgeLength ){
     
 }
 
+// Move all boids by one frame with the multi-rate scheme.
+// Boids free of hard-core repulsion take a single Euler step. Boids within R_B
+// of a neighbour take sub-steps, re-evaluating the repulsion at each sub-step
+// while the rest of their non-normalized velocity stays fixed for the frame.
+//
+void ofApp::updateMultiRate(){
+    
+    const int K = subSteps;
+    
+    for ( unsigned int i = 0; i < b.size(); i++ ){
+        if ( n_b[i].empty() ){ b[i].update(); }
+    }
+    
+    for ( int s = 0; s < K; s++ ){
+        
+        for ( unsigned int i = 0; i < b.size(); i++ ){
+            if ( s == 0 || n_b[i].empty() ){ continue; }
+            ofVec3f v2 = ofVec3f( 0, 0, 0 );
+            
+            for ( unsigned int k = 0; k < n_b[i].size(); k++ ){
+                int j = n_b[i][k];
+                ofVec3f p_j = b[j].getPosition();
+                if ( n_b[j].empty() ){ p_j -= b[j].getVelocity() * ( 1.0 - double(s)/K ); }
+                ofVec3f r_ij = periodicDisplacement( b[i].getPosition(), p_j );
+                if ( r_ij.length() < R_B ){ v2 += r_ij.scale(-INF_NUMERICAL); }
+            }
+            
+            b[i].setVelocity( V_soft[i] + BETA * v2 );
+        }
+        
+        for ( unsigned int i = 0; i < b.size(); i++ ){
+            if ( !n_b[i].empty() ){ b[i].update(K); }
+        }
+    }
+    
+}
+
+// Sort the boids along a Morton curve of their positions, such that
+// spatial neighbours are also close in memory. Their external ids follow them.
+//
+void ofApp::reorderBoids(){
+    
+    arenaVector<uint32_t> keys( b.size(), 0, arenaAllocator<uint32_t>(scratch) );
+    arenaVector<int> order( b.size(), 0, arenaAllocator<int>(scratch) );
+    arenaVector<char> placed( b.size(), 0, arenaAllocator<char>(scratch) );
+    
+    for ( unsigned int i = 0; i < b.size(); i++ ){ keys[i] = mortonKey(b[i].getPosition()); }
+    iota( order.begin(), order.end(), 0 );
+    sort( order.begin(), order.end(), [&keys]( int i, int j ){ return keys[i] < keys[j]; } );
+    
+    for ( unsigned int k = 0; k < b.size(); k++ ){
+        if ( placed[k] ){ continue; }
+        
+        boid first = std::move(b[k]);
+        int firstId = id[k];
+        unsigned int dst = k;
+        
+        while ( order[dst] != (int)k ){
+            b[dst] = std::move(b[order[dst]]);
+            id[dst] = id[order[dst]];
+            placed[dst] = 1;
+            dst = order[dst];
+        }
+        
+        b[dst] = std::move(first);
+        id[dst] = firstId;
+        placed[dst] = 1;
+    }
+    
+}
+
+// Apply parameter changes received through telemetry, as with keyPressed.
+//
+void ofApp::applyCommand( const telemetry::command &command ){
+    
+    if ( command.setGamma && std::isfinite(command.gamma) ){ gamma = ofClamp( command.gamma, 0, GAMMA_MAX ); }
+    if ( command.setN_c ){ n_c = ofClamp( command.n_c, 0, min( N_C_MAX, (int)b.size()-2 ) ); }
+    if ( command.setPause ){ playBoids = !command.pause; }
+    if ( command.setReorder ){ reorderInterval = max( command.reorderInterval, 0 ); }
+    
+}
+
+// Rebuild the information shown on screen if the parameters changed.
+//
+void ofApp::updateInfo(){
+    
+    if ( !infoDesc.empty() && gamma == infoGamma && n_c == infoN_c ){ return; }
+    infoGamma = gamma;
+    infoN_c = n_c;
+    
+    std::string gammaString = std::to_string(gamma);
+    
+    infoDesc = "There are " + std::to_string(b.size()) + " birds.\n";
+    infoDesc += "The noise factor is ";
+    infoDesc += gammaString.substr( 0, gammaString.find(".") + 2 );
+    infoDesc += ".\n";
+    infoDesc += "They interact with at most their ";
+    infoDesc += std::to_string(n_c) + " nearest neighbours.";
+    
+    infoHeader = infoTitle + "\n\n" + infoDesc;
+    
+}
+
+// Report the benchmark results on the console.
+//
+void ofApp::reportBenchmark(){
+    
+    ofLogNotice("benchmark") << b.size() << " boids, " << benchmarkFrames << " frames, reorder interval " << reorderInterval;
+    ofLogNotice("benchmark") << "reorder:   " << 1e3 * benchmarkTime[0] / benchmarkFrames << " ms/frame";
+    ofLogNotice("benchmark") << "neighbour: " << 1e3 * benchmarkTime[1] / benchmarkFrames << " ms/frame";
+    ofLogNotice("benchmark") << "velocity:  " << 1e3 * benchmarkTime[2] / benchmarkFrames << " ms/frame";
+    if ( missCounter >= 0 ){
+        ofLogNotice("benchmark") << "cache misses in neighbour and velocity: " << misses / benchmarkFrames << " /frame";
+    }
+    else { ofLogNotice("benchmark") << "cache misses: hardware counters unavailable"; }
+    
+}
+
 // Setup the application.
 //
 void ofApp::setup(){
     
+    if ( benchmarkFrames > 0 ){ ofSeedRandom(BENCHMARK_SEED); }
+    
     ofSetVerticalSync(true);
-    ofSetFrameRate(FPS);
+    ofSetFrameRate( benchmarkFrames > 0 ? 0 : FPS );
     ofEnableAlphaBlending();
     
     n_c = N_C_DEFAULT;
     gamma = GAMMA_DEFAULT;
     playBoids = true;
     wireframeMode = true;
+    reorderInterval = ( benchmarkFrames > 0 && benchmarkReorder >= 0 ) ? benchmarkReorder : REORDER_INTERVAL;
+    integratorMode = INTEGRATOR;
+    subSteps = max( SUB_STEPS, 1 );
     
     boid::setEdgeLength(LENGTH);
     b.assign( NUM_BOIDS, boid() );
@@ -104,6 +373,9 @@ void ofApp::setup(){
         b[i].setName(name);
     }
     
+    id.resize(b.size());
+    iota( id.begin(), id.end(), 0 );
+    
     r = new ofVec3f*[b.size()];
     d = new double*[b.size()];
     l = new line*[b.size()];
@@ -114,6 +386,9 @@ void ofApp::setup(){
         l[i] = new line[b.size()];
     }
     
+    V_soft.assign( b.size(), ofVec3f( 0, 0, 0 ) );
+    n_b.assign( b.size(), vector<int>() );
+    
     cam_pos = CAM_POS_INI;
     cam.setGlobalPosition(cam_pos.inCartesian());
     cam.lookAt(ofVec3f( 0, 0, 0 ));
@@ -121,6 +396,27 @@ void ofApp::setup(){
     
     currentFrame = 0;
     
+    infoTitle = "Statistical Mechanics for Natural Flocks of Birds\n";
+    infoTitle += "(Bialek et al., 2012)";
+    
+    infoComm = "";
+    infoComm += "R: randomize\n";
+    infoComm += "I: switch the integrator\n";
+    infoComm += "W/A/S/D: rotate\n";
+    infoComm += "Q/E: zoom out/in\n";
+    infoComm += "SPACEBAR: play/pause\n";
+    infoComm += "UP/DOWN: change the noise factor\n";
+    infoComm += "LEFT/RIGHT: change the number of neighbours";
+    
+    if ( benchmarkFrames > 0 ){
+        missCounter = openCacheMissCounter();
+        return;
+    }
+    
+    if ( TELEMETRY && !tel.start(TELEMETRY_PORT) ){
+        ofLogError("telemetry") << "could not listen on port " << TELEMETRY_PORT;
+    }
+    
     for ( unsigned int i = 1; i < 100; i++ ){
         std::string suffix = "_" + ofToString(i);
         if ( !ofDirectory::doesDirectoryExist( DIR + suffix ) ){
@@ -129,6 +425,14 @@ void ofApp::setup(){
             break;
         }
     }
+    
+    if ( SAVE_GRAPH && !graph.open( ofToDataPath( DIR + "/" + FILE_NAME + "_" + DIR + ".graph" ), b.size(), N_C_MAX ) ){
+        ofLogError("graphExport") << "could not create graph file in " << DIR;
+    }
+    
+    if ( SAVE_TRAJECTORY && !trajectory.open( ofToDataPath( DIR + "/" + FILE_NAME + "_" + DIR + ".traj" ), b.size(), LENGTH ) ){
+        ofLogError("trajectory") << "could not create trajectory file in " << DIR;
+    }
 
 }
 
@@ -143,7 +447,26 @@ void ofApp::update(){
     cam.setGlobalPosition(cam_pos.inCartesian());
     cam.lookAt(ofVec3f( 0, 0, 0 ));
     
-    if ( playBoids ){ for ( unsigned int i = 0; i < b.size(); i++ ){ b[i].update(); } }
+    telemetry::command command;
+    if ( tel.isRunning() && tel.poll(command) ){ applyCommand(command); }
+    
+    uint64_t t0 = ofGetElapsedTimeMicros();
+    
+    scratch.reset();
+    
+    if ( playBoids ){
+        if ( integratorMode == MULTI_RATE ){ updateMultiRate(); }
+        else { for ( unsigned int i = 0; i < b.size(); i++ ){ b[i].update(); } }
+    }
+    
+    for ( unsigned int i = 0; i < b.size(); i++ ){ n_b[i].clear(); }
+    
+    uint64_t t1 = ofGetElapsedTimeMicros();
+    
+    if ( reorderInterval > 0 && currentFrame % reorderInterval == 0 ){ reorderBoids(); }
+    
+    uint64_t t1b = ofGetElapsedTimeMicros();
+    enableCounter( missCounter, true );
     
     for ( unsigned int i = 0; i < b.size(); i++ ){
         if ( n_c == 0 ){ break; }
@@ -151,69 +474,58 @@ void ofApp::update(){
         
         for ( unsigned int j = i+1; j < b.size(); j++ ){
             
-            ofVec3f r_period = r[i][j] = b[j].getPosition() - b[i].getPosition();
-            const double SAFE_DIST = 0.5 * LENGTH - R_0;
-            
-            for ( int sx = -1; sx <= 1; sx++ ){
-                bool nearBoundary = sx * b[i].getPosition().x > SAFE_DIST;
-                if ( sx != 0 && !nearBoundary ) continue;
-                bool nearBoundaryOpp = sx * b[j].getPosition().x < -SAFE_DIST;
-                if ( sx != 0 && !nearBoundaryOpp ) continue;
-                
-                for ( int sy = -1; sy <= 1; sy++ ){
-                    bool nearBoundary = sy * b[i].getPosition().y > SAFE_DIST;
-                    if ( sy != 0 && !nearBoundary ) continue;
-                    bool nearBoundaryOpp = sy * b[j].getPosition().y < -SAFE_DIST;
-                    if ( sy != 0 && !nearBoundaryOpp ) continue;
-                    
-                    for ( int sz = -1; sz <= 1; sz++ ){
-                        bool nearBoundary = sz * b[i].getPosition().z > SAFE_DIST;
-                        if ( sz != 0 && !nearBoundary ) continue;
-                        bool nearBoundaryOpp = sz * b[j].getPosition().z < -SAFE_DIST;
-                        if ( sz != 0 && !nearBoundaryOpp ) continue;
-                        
-                        ofVec3f r_shift = r[i][j] + LENGTH * ofVec3f( sx, sy, sz );
-                        if ( r_shift.length() < r_period.length() ){ r_period = r_shift; }
-                    }
-                }
-            }
-            r[i][j] = r_period;
+            r[i][j] = periodicDisplacement( b[i].getPosition(), b[j].getPosition() );
             r[j][i] = -r[i][j];
             d[i][j] = r[i][j].length();
             d[j][i] = d[i][j];
         }
     }
     
+    uint64_t t2 = ofGetElapsedTimeMicros();
+    
+    arenaVector<int> smallestIndices( b.size(), 0, arenaAllocator<int>(scratch) );
+    double indexGap = 0;
+    int numEdges = 0;
+    
     for ( unsigned int i = 0; i < b.size(); i++ ){
         if ( n_c == 0 ){ break; }
         
-        vector<double> distances( d[i], d[i] + b.size() );
-        vector<int> smallestIndices = findSmallestIndices( distances, n_c );
+        findSmallestIndices( d[i], smallestIndices, n_c );
         
         ofVec3f v1 = ofVec3f( 0, 0, 0 );
         ofVec3f v2 = ofVec3f( 0, 0, 0 );
+        ofVec3f v2_soft = ofVec3f( 0, 0, 0 );
         
         for ( unsigned int j = 0; j < n_c; j++ ){
             int smallIndex = smallestIndices.at(j);
             l[i][j].start = b[i].getPosition();
             l[i][j].end = b[i].getPosition() + r[i][smallIndex];
-            l[i][j].color = ofVec3f( 0, 0, 0 );
+            l[i][j].tag = edge::NONE;
+            
+            if ( d[i][smallIndex] < R_0 ){
+                indexGap += abs( (int)i - smallIndex );
+                ++numEdges;
+            }
             
             if ( d[i][smallIndex] < R_B ){
                 v1 += b[smallIndex].getVelocity();
                 v2 += r[i][smallIndex].scale(-INF_NUMERICAL);
-                l[i][j].color.x = 255;
+                n_b[i].push_back(smallIndex);
+                if ( graph.isOpen() ){ graph.addEdge( id[i], id[smallIndex], edge::REPULSION ); }
+                l[i][j].tag = edge::REPULSION;
             }
             else if ( d[i][smallIndex] < R_A ){
                 double scaleFactor = 0.25 * ( d[i][smallIndex] - R_E )/( R_A - R_E );
                 v1 += b[smallIndex].getVelocity();
-                v2 += r[i][smallIndex].scale(scaleFactor);
-                l[i][j].color.z = 255;
+                v2_soft += r[i][smallIndex].scale(scaleFactor);
+                if ( graph.isOpen() ){ graph.addEdge( id[i], id[smallIndex], edge::EQUILIBRIUM ); }
+                l[i][j].tag = edge::EQUILIBRIUM;
             }
             else if (d[i][smallIndex] < R_0){
                 v1 += b[smallIndex].getVelocity();
-                v2 += r[i][smallIndex].normalize();
-                l[i][j].color.y = 255;
+                v2_soft += r[i][smallIndex].normalize();
+                if ( graph.isOpen() ){ graph.addEdge( id[i], id[smallIndex], edge::ATTRACTION ); }
+                l[i][j].tag = edge::ATTRACTION;
             }
             else {
                 l[i][j].end = l[i][j].start;
@@ -225,73 +537,109 @@ void ofApp::update(){
         double r_rho = sqrt( 1.0 - r_z * r_z );
         ofVec3f v3 = ofVec3f( r_rho * cos( r_theta ), r_rho * sin( r_theta ), r_z );
         
-        b[i].setVelocity( ALPHA * v1 + BETA * v2 + gamma * n_c * v3 );
+        V_soft[i] = ALPHA * v1 + BETA * v2_soft + gamma * n_c * v3;
+        b[i].setVelocity( V_soft[i] + BETA * v2 );
     }
 
+    enableCounter( missCounter, false );
+    uint64_t t3 = ofGetElapsedTimeMicros();
+    
     ++currentFrame;
     
+    if ( benchmarkFrames > 0 ){
+        benchmarkTime[0] += 1e-6 * ( t1b - t1 );
+        benchmarkTime[1] += 1e-6 * ( t2 - t1b );
+        benchmarkTime[2] += 1e-6 * ( t3 - t2 );
+        if ( currentFrame >= benchmarkFrames ){
+            misses = readCounter(missCounter);
+            reportBenchmark();
+            ofExit(0);
+        }
+    }
+    
+    if ( graph.isOpen() ){ graph.endFrame(currentFrame); }
+    
+    if ( trajectory.isOpen() ){
+        for ( unsigned int i = 0; i < b.size(); i++ ){ trajectory.setPosition( id[i], b[i].getPosition() ); }
+        trajectory.endFrame( currentFrame, cam_pos );
+    }
+    
+    if ( tel.isRunning() ){
+        ofVec3f v_sum = ofVec3f( 0, 0, 0 );
+        double v_norm = 0;
+        stats.repulsed = 0;
+        for ( unsigned int i = 0; i < b.size(); i++ ){
+            v_sum += b[i].getVelocity();
+            v_norm += b[i].getVelocity().length();
+            if ( !n_b[i].empty() ){ ++stats.repulsed; }
+        }
+        
+        stats.frame = currentFrame;
+        stats.stepRate = ofGetFrameRate();
+        stats.integrateTime = 1e-6 * ( t1 - t0 );
+        stats.reorderTime = 1e-6 * ( t1b - t1 );
+        stats.neighbourTime = 1e-6 * ( t2 - t1b );
+        stats.velocityTime = 1e-6 * ( t3 - t2 );
+        stats.numBoids = b.size();
+        stats.n_c = n_c;
+        stats.gamma = gamma;
+        stats.playing = playBoids;
+        stats.polarization = ( v_norm > 0 ) ? v_sum.length() / v_norm : 0;
+        stats.arenaHighWater = scratch.getHighWater();
+        stats.arenaOverflows = scratch.getOverflows();
+        stats.reorderInterval = reorderInterval;
+        stats.indexGap = ( numEdges > 0 ) ? indexGap / numEdges : 0;
+        tel.publish(stats);
+    }
+    
 }
 
 // Draw.
 //
 void ofApp::draw(){
     
-    if ( wireframeMode ){ ofBackground(ofColor( 0, 0, 0 )); }
-    else { ofBackground(ofColor( 96, 168, 196 )); }
+    if ( benchmarkFrames > 0 ){ return; }
+    
+    uint64_t t0 = ofGetElapsedTimeMicros();
+    
+    ofBackground(scene::backgroundColor( wireframeMode ));
     
     cam.begin();
     ofEnableDepthTest();
     ofPushMatrix();
-        ofScale(100);
-        ofSetColor( 255, 255, 255, 50 );
+        ofScale(scene::SCALE);
+        ofSetColor(scene::boxColor());
         ofNoFill();
         ofDrawBox( ofVec3f( 0, 0, 0 ), LENGTH );
         ofFill();
         for ( unsigned int i = 0; i < b.size(); i++ ){
-            ofSetColor(0);
             if ( wireframeMode ){
                 for ( unsigned int j = 0; j < n_c; j++ ){
-                    ofSetColor( l[i][j].color.x, l[i][j].color.y, l[i][j].color.z, 100 );
+                    ofSetColor(scene::zoneColor( l[i][j].tag ));
                     ofDrawLine( l[i][j].start, l[i][j].end );
                 }
-                ofSetColor(255);
             }
+            ofSetColor(scene::boidColor( wireframeMode ));
             b[i].draw();
         }
     ofPopMatrix();
     ofDisableDepthTest();
     cam.end();
     
-    std::string title = "Statistical Mechanics for Natural Flocks of Birds\n";
-    title += "(Bialek et al., 2012)";
-    
-    std::string desc = "There are " + std::to_string(b.size()) + " birds.\n";
-    desc += "The noise factor is ";
-    desc += std::to_string(gamma).substr( 0, std::to_string(gamma).find(".") + 2 );
-    desc += ".\n";
-    desc += "They interact with at most their ";
-    desc += std::to_string(n_c) + " nearest neighbours.";
-    
-    std::string comm = "";
-    comm += "R: randomize\n";
-    comm += "W/A/S/D: rotate\n";
-    comm += "Q/E: zoom out/in\n";
-    comm += "SPACEBAR: play/pause\n";
-    comm += "UP/DOWN: change the noise factor\n";
-    comm += "LEFT/RIGHT: change the number of neighbours";
+    updateInfo();
     
     const int LINE_HEIGHT = 10;
     const int N_LINES_DESC = 3;
-    const int N_LINES_COMM = 6;
+    const int N_LINES_COMM = 7;
     
     ofSetColor(255);
     if ( SHOW_COMM ){
-        if ( SHOW_INFO ){ ofDrawBitmapString( title + "\n\n" + desc, 20, 20 ); }
-        ofDrawBitmapString( comm, 20, ofGetHeight() - ( 20 + N_LINES_COMM*LINE_HEIGHT ));
+        if ( SHOW_INFO ){ ofDrawBitmapString( infoHeader, 20, 20 ); }
+        ofDrawBitmapString( infoComm, 20, ofGetHeight() - ( 20 + N_LINES_COMM*LINE_HEIGHT ));
     }
     else if ( SHOW_INFO ){
-            ofDrawBitmapString( title, 20, 10 + LINE_HEIGHT );
-            ofDrawBitmapString( desc, 20, ofGetHeight() - ( 10 + N_LINES_DESC*LINE_HEIGHT ));
+            ofDrawBitmapString( infoTitle, 20, 10 + LINE_HEIGHT );
+            ofDrawBitmapString( infoDesc, 20, ofGetHeight() - ( 10 + N_LINES_DESC*LINE_HEIGHT ));
     }
     
     if ( SAVE ){
@@ -299,6 +647,21 @@ void ofApp::draw(){
         if ( currentFrame >= FPS*TIME ){ ofExit(0); }
     }
     
+    stats.drawTime = 1e-6 * ( ofGetElapsedTimeMicros() - t0 );
+    
+}
+
+// Exit the application.
+//
+void ofApp::exit(){
+    
+    tel.stop();
+#ifdef __linux__
+    if ( missCounter >= 0 ){ close(missCounter); }
+#endif
+    graph.close();
+    trajectory.close();
+    
 }
 
 //--------------------------------------------------------------
@@ -307,6 +670,7 @@ void ofApp::keyPressed( int key ){
     if( key == 'r' ){ randomizeBoids(LENGTH_RANDOMIZE); }
     if( key == ' ' ){ playBoids = !playBoids; }
     if( key == 'p' ){ wireframeMode = !wireframeMode; }
+    if( key == 'i' ){ integratorMode = ( integratorMode == EULER ) ? MULTI_RATE : EULER; }
     if( key == OF_KEY_RIGHT && n_c < b.size()-2 ){ ++n_c; }
     if( key == OF_KEY_RIGHT && n_c > N_C_MAX ){ n_c = N_C_MAX; }
     if( key == OF_KEY_LEFT && n_c > 0 ){ --n_c; }
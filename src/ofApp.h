@@ -1,20 +1,26 @@
 #pragma once
 #include "ofMain.h"
+#include "arena.h"
 #include "boid.h"
+#include "graphExport.h"
+#include "scene.h"
 #include "spheCoord.h"
+#include "telemetry.h"
+#include "trajectory.h"
 
 //========================================================================
 // Line class
 //========================================================================
 //
-// A line in 3D space that has a start point, an end point, and a RGB color.
+// A line in 3D space that has a start point, an end point, and the zone
+// of the interaction it shows, which sets its color.
 //
 class line {
     
 public:
     ofVec3f start;
     ofVec3f end;
-    ofVec3f color;
+    edge::zone tag;
     
 };
 
@@ -26,6 +32,17 @@ class ofApp : public ofBaseApp {
     
 public:
     
+    //--------------------------------------------------------------
+    // Public enumeration
+    //--------------------------------------------------------------
+    
+    // Time integration scheme of the positions.
+    // EULER moves every boid with one explicit step per frame;
+    // MULTI_RATE additionally sub-steps boids under hard-core repulsion.
+    //
+    enum integrator { EULER, MULTI_RATE };
+    
+    
     //--------------------------------------------------------------
     // Public member variables
     //--------------------------------------------------------------
@@ -34,11 +51,19 @@ public:
     double gamma;
     
     vector <boid> b;
+    vector <int> id;
     ofVec3f** r;
     double** d;
     line** l;
     
+    vector <ofVec3f> V_soft;
+    vector <vector <int>> n_b;
+    
+    integrator integratorMode;
+    int subSteps;
+    
     bool playBoids;
+    int reorderInterval;
     int currentFrame;
     bool wireframeMode;
     
@@ -46,16 +71,50 @@ public:
     spheCoord cam_pos;
     spheCoord cam_deltaPosition;
     
+    telemetry tel;
+    telemetry::sample stats;
+    
+    int benchmarkFrames;
+    int benchmarkReorder;
+    double benchmarkTime[3];
+    int missCounter;
+    long long misses;
+    
+    arena scratch;
+    graphWriter graph;
+    trajectoryWriter trajectory;
+    
+    std::string infoTitle;
+    std::string infoDesc;
+    std::string infoHeader;
+    std::string infoComm;
+    double infoGamma;
+    int infoN_c;
+    
+    
+    //--------------------------------------------------------------
+    // Public class constructors
+    //--------------------------------------------------------------
+    
+    ofApp();
+    ofApp( const int &benchmarkFrames, const int &benchmarkReorder );
+    
     
     //--------------------------------------------------------------
     // Public member functions
     //--------------------------------------------------------------
     
     void randomizeBoids( const double &edgeLength );
+    void updateMultiRate();
+    void reorderBoids();
+    void applyCommand( const telemetry::command &command );
+    void updateInfo();
+    void reportBenchmark();
     
     void setup();
     void update();
     void draw();
+    void exit();
 
     void keyPressed(int key);
     void keyReleased(int key);
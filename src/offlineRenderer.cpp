@@ -0,0 +1,213 @@
+#include "offlineRenderer.h"
+
+//--------------------------------------------------------------
+// Render parameters
+//--------------------------------------------------------------
+
+namespace {
+    
+const int WIDTH = 3840; // output width in pixels
+const int HEIGHT = 2160; // output height in pixels
+const int SAMPLES = 8; // multisampling anti-aliasing samples
+const int RESOLUTION = 16; // sphere resolution of the boids, finer than the live view
+const bool WIREFRAME = true; // look of the simulation, as toggled by 'P'
+    
+}
+
+
+//--------------------------------------------------------------
+// Public class constructor
+//--------------------------------------------------------------
+
+offlineRenderer::offlineRenderer( const std::string &path, const std::string &keyframePath,
+                                  const vector <int> &slots, const int &numWorkers ):
+    path(path),
+    keyframePath(keyframePath),
+    assigned( numWorkers, false ),
+    numWorkers(numWorkers),
+    index(numWorkers),
+    failed(false),
+    frame(0)
+{
+    
+    for ( unsigned int k = 0; k < slots.size(); k++ ){
+        assigned[slots[k]] = true;
+        index = min( index, slots[k] );
+    }
+    
+}
+
+
+//--------------------------------------------------------------
+// Private member functions
+//--------------------------------------------------------------
+
+// Load camera keyframes from a text file with one "frame radius theta phi"
+// entry per line, sorted by frame. Lines starting with '#' are ignored.
+//
+bool offlineRenderer::loadKeyframes(){
+    
+    std::ifstream file(keyframePath);
+    if ( !file.is_open() ){ return false; }
+    
+    std::string entry;
+    while ( std::getline( file, entry ) ){
+        if ( entry.empty() || entry[0] == '#' ){ continue; }
+        std::stringstream ss(entry);
+        keyframe k;
+        if ( ss >> k.frame >> k.position.radius >> k.position.theta >> k.position.phi ){ keyframes.push_back(k); }
+    }
+    
+    sort( keyframes.begin(), keyframes.end(),
+         []( const keyframe &a, const keyframe &b ){ return a.frame < b.frame; } );
+    return !keyframes.empty();
+    
+}
+
+// Camera position at a frame, interpolated linearly between keyframes.
+//
+spheCoord offlineRenderer::cameraAt( const int &frame, const spheCoord &recorded ){
+    
+    if ( keyframes.empty() ){ return recorded; }
+    if ( frame <= keyframes.front().frame ){ return keyframes.front().position; }
+    if ( frame >= keyframes.back().frame ){ return keyframes.back().position; }
+    
+    unsigned int k = 1;
+    while ( keyframes[k].frame < frame ){ ++k; }
+    const keyframe &a = keyframes[k-1];
+    const keyframe &b = keyframes[k];
+    double t = double( frame - a.frame ) / ( b.frame - a.frame );
+    
+    return spheCoord( a.position.radius + t * ( b.position.radius - a.position.radius ),
+                      a.position.theta + t * ( b.position.theta - a.position.theta ),
+                      a.position.phi + t * ( b.position.phi - a.position.phi ) );
+    
+}
+
+// Apply all recorded edge changes up to a frame.
+// Frames only move forward, so each change is applied once per worker.
+//
+void offlineRenderer::advanceEdges( const int &frame ){
+    
+    for ( int i = 0; i < graph.getNumBoids(); i++ ){
+        const vector<edgeChange> &changes = graph.getHistory(i);
+        
+        for ( ; cursors[i] < changes.size() && changes[cursors[i]].frame <= frame; cursors[i]++ ){
+            graphReader::applyChange( edges[i], changes[cursors[i]] );
+        }
+    }
+    
+}
+
+
+//--------------------------------------------------------------
+// Public member functions
+//--------------------------------------------------------------
+
+// Setup the renderer.
+//
+void offlineRenderer::setup(){
+    
+    ofSetVerticalSync(false);
+    ofSetFrameRate(0);
+    ofEnableAlphaBlending();
+    
+    if ( !trajectory.open(path) ){
+        ofLogError("offlineRenderer") << "could not read trajectory " << path;
+        failed = true;
+        ofExit(1);
+        return;
+    }
+    
+    std::string base = path.substr( 0, path.rfind('.') );
+    if ( graph.open( base + ".graph" ) && graph.getNumBoids() == trajectory.getNumBoids() ){
+        edges.assign( graph.getNumBoids(), vector<edge>() );
+        cursors.assign( graph.getNumBoids(), 0 );
+    }
+    else { ofLogNotice("offlineRenderer") << "no interaction graph for " << path << ", drawing boids only"; }
+    
+    if ( !keyframePath.empty() && !loadKeyframes() ){
+        ofLogError("offlineRenderer") << "could not read keyframes " << keyframePath << ", using the recorded camera";
+    }
+    
+    outDir = base + "_render";
+    ofDirectory::createDirectory( outDir, false, true );
+    
+    ofFbo::Settings settings;
+    settings.width = WIDTH;
+    settings.height = HEIGHT;
+    settings.internalformat = GL_RGB;
+    settings.numSamples = SAMPLES;
+    fbo.allocate(settings);
+    
+}
+
+// Read the next frame of this worker.
+//
+void offlineRenderer::update(){
+    
+    spheCoord recorded;
+    if ( index >= trajectory.getNumFrames() ){
+        ofExit(0);
+        return;
+    }
+    if ( !trajectory.readFrame( index, frame, recorded, positions ) ){
+        ofLogError("offlineRenderer") << "could not read frame " << index << " of " << path;
+        failed = true;
+        ofExit(1);
+        return;
+    }
+    
+    if ( !edges.empty() ){ advanceEdges(frame); }
+    cam_pos = cameraAt( frame, recorded );
+    cam.setGlobalPosition(cam_pos.inCartesian());
+    cam.lookAt(ofVec3f( 0, 0, 0 ));
+    
+}
+
+// Render the frame offscreen and save it.
+//
+void offlineRenderer::draw(){
+    
+    if ( index >= trajectory.getNumFrames() ){ return; }
+    
+    const double length = trajectory.getEdgeLength();
+    
+    fbo.begin();
+    ofBackground(scene::backgroundColor( WIREFRAME ));
+    
+    cam.begin(ofRectangle( 0, 0, WIDTH, HEIGHT ));
+    ofEnableDepthTest();
+    ofPushMatrix();
+        ofScale(scene::SCALE);
+        ofSetColor(scene::boxColor());
+        ofNoFill();
+        ofDrawBox( ofVec3f( 0, 0, 0 ), length );
+        ofFill();
+        ofSetSphereResolution(RESOLUTION);
+        for ( unsigned int i = 0; i < positions.size(); i++ ){
+            if ( WIREFRAME && !edges.empty() ){
+                for ( unsigned int k = 0; k < edges[i].size(); k++ ){
+                    const edge &e = edges[i][k];
+                    ofVec3f r = positions[e.neighbour] - positions[i];
+                    r.x -= length * round( r.x / length );
+                    r.y -= length * round( r.y / length );
+                    r.z -= length * round( r.z / length );
+                    ofSetColor(scene::zoneColor( e.tag ));
+                    ofDrawLine( positions[i], positions[i] + r );
+                }
+            }
+            ofSetColor(scene::boidColor( WIREFRAME ));
+            ofDrawSphere( positions[i], scene::BOID_SIZE );
+        }
+    ofPopMatrix();
+    ofDisableDepthTest();
+    cam.end();
+    fbo.end();
+    
+    fbo.readToPixels(pixels);
+    ofSaveImage( pixels, outDir + "/" + ofToString( frame, 5, '0' ) + ".png" );
+    
+    do { index++; } while ( !assigned[index % numWorkers] );
+    
+}
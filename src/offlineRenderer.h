@@ -0,0 +1,94 @@
+#pragma once
+#include "ofMain.h"
+#include "graphExport.h"
+#include "scene.h"
+#include "spheCoord.h"
+#include "trajectory.h"
+
+//========================================================================
+// Keyframe class
+//========================================================================
+//
+// A camera position at a given frame of a recorded run.
+//
+class keyframe {
+    
+public:
+    int frame;
+    spheCoord position;
+    
+};
+
+//========================================================================
+// Offline renderer class
+//========================================================================
+//
+// Renders a recorded run frame by frame into an offscreen framebuffer at a
+// resolution and quality independent of the window and of real time.
+// Frames are split among numWorkers slots, frame k belonging to slot
+// k % numWorkers; each worker renders the frames of the slots it is given.
+// The camera follows the recorded path, unless keyframes are given.
+// Paths are expected to be absolute, such that reading the recording and
+// saving images through ofToDataPath refer to the same directory.
+//
+class offlineRenderer : public ofBaseApp {
+    
+public:
+    
+    //--------------------------------------------------------------
+    // Public class constructor
+    //--------------------------------------------------------------
+    
+    offlineRenderer( const std::string &path, const std::string &keyframePath,
+                     const vector <int> &slots, const int &numWorkers );
+    
+    
+    //--------------------------------------------------------------
+    // Public member functions
+    //--------------------------------------------------------------
+    
+    void setup();
+    void update();
+    void draw();
+    
+    bool hasFailed(){ return failed; }
+    
+    
+private:
+    
+    //--------------------------------------------------------------
+    // Private member variables
+    //--------------------------------------------------------------
+    
+    std::string path;
+    std::string keyframePath;
+    std::string outDir;
+    vector <bool> assigned;
+    int numWorkers;
+    int index;
+    bool failed;
+    
+    trajectoryReader trajectory;
+    graphReader graph;
+    vector <keyframe> keyframes;
+    
+    int frame;
+    spheCoord cam_pos;
+    vector <ofVec3f> positions;
+    vector <vector <edge>> edges;
+    vector <unsigned int> cursors;
+    
+    ofCamera cam;
+    ofFbo fbo;
+    ofPixels pixels;
+    
+    
+    //--------------------------------------------------------------
+    // Private member functions
+    //--------------------------------------------------------------
+    
+    bool loadKeyframes();
+    spheCoord cameraAt( const int &frame, const spheCoord &recorded );
+    void advanceEdges( const int &frame );
+    
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include "ofMain.h"
+#include "graphExport.h"
+
+//========================================================================
+// Scene constants
+//========================================================================
+//
+// The look of the simulation, shared by the live view and the offline
+// renderer such that rendered runs match what is seen on screen.
+//
+namespace scene {
+
+    const double BOID_SIZE = 0.05; // boid radius
+    const double SCALE = 100; // drawing units per unit of length
+
+    // Background, depending on whether the view is in wireframe mode.
+    //
+    inline ofColor backgroundColor( const bool &wireframe ){
+        return wireframe ? ofColor( 0, 0, 0 ) : ofColor( 96, 168, 196 );
+    }
+
+    // Boids, depending on whether the view is in wireframe mode.
+    //
+    inline ofColor boidColor( const bool &wireframe ){
+        return wireframe ? ofColor( 255, 255, 255 ) : ofColor( 0, 0, 0 );
+    }
+
+    // Edges of the simulation box.
+    //
+    inline ofColor boxColor(){
+        return ofColor( 255, 255, 255, 50 );
+    }
+
+    // Lines between interacting boids: red under hard-core repulsion, blue
+    // near the equilibrium distance, and green where the force is constant.
+    //
+    inline ofColor zoneColor( const edge::zone &tag ){
+        return ofColor( tag == edge::REPULSION ? 255 : 0,
+                        tag == edge::ATTRACTION ? 255 : 0,
+                        tag == edge::EQUILIBRIUM ? 255 : 0, 100 );
+    }
+
+}
@@ -0,0 +1,335 @@
+#include "telemetry.h"
+#include <arpa/inet.h>
+#include <cmath>
+#include <limits>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+//--------------------------------------------------------------
+// Constants
+//--------------------------------------------------------------
+
+namespace {
+    
+    const int BACKLOG = 4;
+    const int POLL_TIMEOUT = 200; // milliseconds between checks for stop()
+    const int BUFFER_SIZE = 2048;
+    
+}
+
+
+//--------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------
+
+// Return the value of a key in a query string such as "a=1&b=2".
+//
+static bool findQueryValue( const std::string &query, const std::string &key, std::string &value ){
+    
+    std::stringstream ss(query);
+    std::string pair;
+    
+    while ( std::getline( ss, pair, '&' ) ){
+        size_t eq = pair.find('=');
+        if ( eq != std::string::npos && pair.substr( 0, eq ) == key ){
+            value = pair.substr( eq + 1 );
+            return true;
+        }
+    }
+    
+    return false;
+    
+}
+
+// Parse a whole string as a finite number. Return false on any leftover character.
+//
+static bool parseNumber( const std::string &text, double &number ){
+    
+    if ( text.empty() ){ return false; }
+    char* end = nullptr;
+    number = std::strtod( text.c_str(), &end );
+    return *end == '\0' && std::isfinite(number);
+    
+}
+
+// Parse a whole string as an integer. Return false on any leftover character.
+//
+static bool parseInteger( const std::string &text, int &number ){
+    
+    double value;
+    if ( !parseNumber( text, value ) || value != std::floor(value) ){ return false; }
+    if ( value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max() ){ return false; }
+    number = int(value);
+    return true;
+    
+}
+
+// Return the peak resident memory of the process in bytes.
+//
+static long maxResidentBytes(){
+    
+    struct rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024L;
+#endif
+    
+}
+
+// Write a full HTTP response to a socket.
+//
+static void respond( const int &fd, const std::string &status, const std::string &body ){
+    
+    std::string response = "HTTP/1.0 " + status + "\r\n";
+    response += "Content-Type: text/plain; version=0.0.4\r\n";
+    response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    
+    size_t sent = 0;
+    while ( sent < response.size() ){
+        ssize_t n = send( fd, response.data() + sent, response.size() - sent, 0 );
+        if ( n <= 0 ){ break; }
+        sent += n;
+    }
+    
+}
+
+
+//--------------------------------------------------------------
+// Public class constructor & destructor
+//--------------------------------------------------------------
+
+telemetry::telemetry():
+    running(false),
+    listenFd(-1),
+    hasPending(false)
+{}
+
+telemetry::~telemetry(){
+    
+    stop();
+    
+}
+
+
+//--------------------------------------------------------------
+// Public member functions
+//--------------------------------------------------------------
+
+// Listen on a local port and serve requests on a separate thread.
+//
+bool telemetry::start( const int &port ){
+    
+    if ( running ){ return true; }
+    
+    listenFd = socket( AF_INET, SOCK_STREAM, 0 );
+    if ( listenFd < 0 ){ return false; }
+    
+    int reuse = 1;
+    setsockopt( listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse) );
+    
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    if ( bind( listenFd, (sockaddr*)&addr, sizeof(addr) ) < 0 || listen( listenFd, BACKLOG ) < 0 ){
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    
+    running = true;
+    worker = std::thread( &telemetry::run, this );
+    return true;
+    
+}
+
+// Stop serving and wait for the thread to finish.
+//
+void telemetry::stop(){
+    
+    running = false;
+    if ( worker.joinable() ){ worker.join(); }
+    if ( listenFd >= 0 ){ close(listenFd); }
+    listenFd = -1;
+    
+}
+
+// Publish the latest sample, unless the endpoint is busy reading it.
+//
+void telemetry::publish( const sample &sample_ ){
+    
+    std::unique_lock<std::mutex> lock( mutex, std::try_to_lock );
+    if ( lock.owns_lock() ){ latest = sample_; }
+    
+}
+
+// Retrieve pending parameter changes, if any and if not busy.
+//
+bool telemetry::poll( command &command_ ){
+    
+    std::unique_lock<std::mutex> lock( mutex, std::try_to_lock );
+    if ( !lock.owns_lock() || !hasPending ){ return false; }
+    
+    command_ = pending;
+    pending = command();
+    hasPending = false;
+    return true;
+    
+}
+
+
+//--------------------------------------------------------------
+// Private member functions
+//--------------------------------------------------------------
+
+// Accept and handle connections one at a time until stopped.
+//
+void telemetry::run(){
+    
+    while ( running ){
+        pollfd pfd = { listenFd, POLLIN, 0 };
+        if ( ::poll( &pfd, 1, POLL_TIMEOUT ) <= 0 ){ continue; }
+        
+        int fd = accept( listenFd, nullptr, nullptr );
+        if ( fd < 0 ){ continue; }
+        handle(fd);
+        close(fd);
+    }
+    
+}
+
+// Handle one request: GET /metrics, or GET/POST /set?gamma=&n_c=&pause=&reorder= .
+//
+void telemetry::handle( const int &fd ){
+    
+    char buffer[BUFFER_SIZE];
+    pollfd pfd = { fd, POLLIN, 0 };
+    if ( ::poll( &pfd, 1, POLL_TIMEOUT ) <= 0 ){ return; }
+    ssize_t n = recv( fd, buffer, sizeof(buffer) - 1, 0 );
+    if ( n <= 0 ){ return; }
+    buffer[n] = '\0';
+    
+    std::stringstream request(buffer);
+    std::string method, target;
+    request >> method >> target;
+    
+    std::string path = target.substr( 0, target.find('?') );
+    std::string query = "";
+    if ( target.find('?') != std::string::npos ){ query = target.substr( target.find('?') + 1 ); }
+    
+    if ( path == "/metrics" ){
+        respond( fd, "200 OK", metrics() );
+    }
+    else if ( path == "/set" ){
+        command received;
+        std::string value;
+        
+        bool valid = true;
+        
+        if ( findQueryValue( query, "gamma", value ) ){
+            valid = valid && parseNumber( value, received.gamma );
+            received.setGamma = true;
+        }
+        if ( findQueryValue( query, "n_c", value ) ){
+            valid = valid && parseInteger( value, received.n_c );
+            received.setN_c = true;
+        }
+        if ( findQueryValue( query, "pause", value ) ){
+            valid = valid && ( value == "0" || value == "1" || value == "false" || value == "true" );
+            received.pause = ( value == "1" || value == "true" );
+            received.setPause = true;
+        }
+        if ( findQueryValue( query, "reorder", value ) ){
+            valid = valid && parseInteger( value, received.reorderInterval );
+            received.setReorder = true;
+        }
+        
+        if ( !valid ){
+            respond( fd, "400 Bad Request", "invalid parameter value\n" );
+            return;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if ( received.setGamma ){ pending.gamma = received.gamma; pending.setGamma = true; }
+            if ( received.setN_c ){ pending.n_c = received.n_c; pending.setN_c = true; }
+            if ( received.setPause ){ pending.pause = received.pause; pending.setPause = true; }
+            if ( received.setReorder ){ pending.reorderInterval = received.reorderInterval; pending.setReorder = true; }
+            hasPending = true;
+        }
+        respond( fd, "200 OK", "ok\n" );
+    }
+    else {
+        respond( fd, "404 Not Found", "not found\n" );
+    }
+    
+}
+
+// Format the latest sample in Prometheus text format.
+//
+std::string telemetry::metrics(){
+    
+    sample s;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        s = latest;
+    }
+    
+    std::stringstream out;
+    out << "# HELP flocking_frames_total Frames simulated since setup.\n";
+    out << "# TYPE flocking_frames_total counter\n";
+    out << "flocking_frames_total " << s.frame << "\n";
+    out << "# HELP flocking_step_rate Frames simulated per second.\n";
+    out << "# TYPE flocking_step_rate gauge\n";
+    out << "flocking_step_rate " << s.stepRate << "\n";
+    out << "# HELP flocking_phase_seconds Duration of each phase of the last frame.\n";
+    out << "# TYPE flocking_phase_seconds gauge\n";
+    out << "flocking_phase_seconds{phase=\"integrate\"} " << s.integrateTime << "\n";
+    out << "flocking_phase_seconds{phase=\"reorder\"} " << s.reorderTime << "\n";
+    out << "flocking_phase_seconds{phase=\"neighbour\"} " << s.neighbourTime << "\n";
+    out << "flocking_phase_seconds{phase=\"velocity\"} " << s.velocityTime << "\n";
+    out << "flocking_phase_seconds{phase=\"draw\"} " << s.drawTime << "\n";
+    out << "# HELP flocking_max_resident_bytes Peak resident memory of the process.\n";
+    out << "# TYPE flocking_max_resident_bytes gauge\n";
+    out << "flocking_max_resident_bytes " << maxResidentBytes() << "\n";
+    out << "# HELP flocking_boids Total number of boids.\n";
+    out << "# TYPE flocking_boids gauge\n";
+    out << "flocking_boids " << s.numBoids << "\n";
+    out << "# HELP flocking_n_c Interaction range.\n";
+    out << "# TYPE flocking_n_c gauge\n";
+    out << "flocking_n_c " << s.n_c << "\n";
+    out << "# HELP flocking_gamma Noise strength.\n";
+    out << "# TYPE flocking_gamma gauge\n";
+    out << "flocking_gamma " << s.gamma << "\n";
+    out << "# HELP flocking_playing Whether the simulation is running.\n";
+    out << "# TYPE flocking_playing gauge\n";
+    out << "flocking_playing " << ( s.playing ? 1 : 0 ) << "\n";
+    out << "# HELP flocking_polarization Norm of the mean velocity over v_0.\n";
+    out << "# TYPE flocking_polarization gauge\n";
+    out << "flocking_polarization " << s.polarization << "\n";
+    out << "# HELP flocking_repulsed_boids Boids under hard-core repulsion.\n";
+    out << "# TYPE flocking_repulsed_boids gauge\n";
+    out << "flocking_repulsed_boids " << s.repulsed << "\n";
+    out << "# HELP flocking_arena_high_water_bytes Peak scratch memory used within one frame.\n";
+    out << "# TYPE flocking_arena_high_water_bytes gauge\n";
+    out << "flocking_arena_high_water_bytes " << s.arenaHighWater << "\n";
+    out << "# HELP flocking_arena_overflows_total Scratch requests that did not fit the arena.\n";
+    out << "# TYPE flocking_arena_overflows_total counter\n";
+    out << "flocking_arena_overflows_total " << s.arenaOverflows << "\n";
+    out << "# HELP flocking_reorder_interval Frames between spatial reorderings of the boids.\n";
+    out << "# TYPE flocking_reorder_interval gauge\n";
+    out << "flocking_reorder_interval " << s.reorderInterval << "\n";
+    out << "# HELP flocking_neighbour_index_gap Mean distance in memory between interacting boids.\n";
+    out << "# TYPE flocking_neighbour_index_gap gauge\n";
+    out << "flocking_neighbour_index_gap " << s.indexGap << "\n";
+    return out.str();
+    
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "ofMain.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+//========================================================================
+// Telemetry class
+//========================================================================
+//
+// A local HTTP endpoint running on its own thread. It serves the latest
+// published sample in Prometheus text format on /metrics and queues
+// parameter changes received on /set for the application to apply.
+// The simulation side only ever tries to lock, such that it never blocks.
+//
+class telemetry {
+    
+public:
+    
+    //--------------------------------------------------------------
+    // Public nested classes
+    //--------------------------------------------------------------
+    
+    // Observables and parameters of the simulation at one frame.
+    //
+    class sample {
+        
+    public:
+        int frame = 0;
+        double stepRate = 0;
+        double integrateTime = 0;
+        double reorderTime = 0;
+        double neighbourTime = 0;
+        double velocityTime = 0;
+        double drawTime = 0;
+        int numBoids = 0;
+        int n_c = 0;
+        double gamma = 0;
+        bool playing = true;
+        double polarization = 0;
+        int repulsed = 0;
+        size_t arenaHighWater = 0;
+        int arenaOverflows = 0;
+        int reorderInterval = 0;
+        double indexGap = 0;
+        
+    };
+    
+    // Parameter changes requested through the endpoint.
+    //
+    class command {
+        
+    public:
+        bool setGamma = false;
+        double gamma = 0;
+        bool setN_c = false;
+        int n_c = 0;
+        bool setPause = false;
+        bool pause = false;
+        bool setReorder = false;
+        int reorderInterval = 0;
+        
+    };
+    
+    
+    //--------------------------------------------------------------
+    // Public class constructor & destructor
+    //--------------------------------------------------------------
+    
+    telemetry();
+    ~telemetry();
+    
+    
+    //--------------------------------------------------------------
+    // Public member functions
+    //--------------------------------------------------------------
+    
+    bool start( const int &port );
+    void stop();
+    
+    bool isRunning(){ return running; }
+    
+    void publish( const sample &sample_ );
+    bool poll( command &command_ );
+    
+    
+private:
+    
+    //--------------------------------------------------------------
+    // Private member variables
+    //--------------------------------------------------------------
+    
+    std::thread worker;
+    std::atomic<bool> running;
+    int listenFd;
+    
+    std::mutex mutex;
+    sample latest;
+    command pending;
+    bool hasPending;
+    
+    
+    //--------------------------------------------------------------
+    // Private member functions
+    //--------------------------------------------------------------
+    
+    void run();
+    void handle( const int &fd );
+    std::string metrics();
+    
+};
@@ -0,0 +1,137 @@
+#include "trajectory.h"
+
+//--------------------------------------------------------------
+// Constants
+//--------------------------------------------------------------
+
+namespace {
+    
+    const char MAGIC[4] = { 'F', 'L', 'K', 'T' };
+    const uint32_t VERSION = 1;
+    const std::streamoff HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t) + sizeof(float);
+    
+}
+
+
+//--------------------------------------------------------------
+// Trajectory writer: public class destructor
+//--------------------------------------------------------------
+
+trajectoryWriter::~trajectoryWriter(){
+    
+    close();
+    
+}
+
+
+//--------------------------------------------------------------
+// Trajectory writer: public member functions
+//--------------------------------------------------------------
+
+// Create the file and write its header.
+//
+bool trajectoryWriter::open( const std::string &path, const int &numBoids, const double &edgeLength ){
+    
+    close();
+    file.open( path, std::ios::binary | std::ios::trunc );
+    if ( !file.is_open() ){ return false; }
+    
+    positions.assign( 3 * numBoids, 0 );
+    
+    uint32_t header[2] = { VERSION, uint32_t(numBoids) };
+    float length = edgeLength;
+    file.write( MAGIC, sizeof(MAGIC) );
+    file.write( (const char*)header, sizeof(header) );
+    file.write( (const char*)&length, sizeof(length) );
+    return file.good();
+    
+}
+
+// Flush and close the file.
+//
+void trajectoryWriter::close(){
+    
+    if ( file.is_open() ){ file.close(); }
+    
+}
+
+// Set the position of a boid in the current frame.
+//
+void trajectoryWriter::setPosition( const int &id, const ofVec3f &position ){
+    
+    positions[3*id] = position.x;
+    positions[3*id + 1] = position.y;
+    positions[3*id + 2] = position.z;
+    
+}
+
+// Write the current frame.
+//
+void trajectoryWriter::endFrame( const int &frame, const spheCoord &camera ){
+    
+    if ( !file.is_open() ){ return; }
+    
+    int32_t index = frame;
+    float cam[3] = { float(camera.radius), float(camera.theta), float(camera.phi) };
+    file.write( (const char*)&index, sizeof(index) );
+    file.write( (const char*)cam, sizeof(cam) );
+    file.write( (const char*)positions.data(), positions.size() * sizeof(float) );
+    
+}
+
+
+//--------------------------------------------------------------
+// Trajectory reader: public member functions
+//--------------------------------------------------------------
+
+// Open a file and read its header.
+//
+bool trajectoryReader::open( const std::string &path ){
+    
+    numBoids = 0;
+    numFrames = 0;
+    if ( file.is_open() ){ file.close(); }
+    file.open( path, std::ios::binary );
+    if ( !file.is_open() ){ return false; }
+    
+    char magic[4];
+    uint32_t header[2];
+    float length;
+    file.read( magic, sizeof(magic) );
+    file.read( (char*)header, sizeof(header) );
+    file.read( (char*)&length, sizeof(length) );
+    if ( !file.good() || !std::equal( magic, magic + 4, MAGIC ) || header[0] != VERSION ){ return false; }
+    
+    numBoids = header[1];
+    edgeLength = length;
+    buffer.resize( 4 + 3 * numBoids );
+    
+    file.seekg( 0, std::ios::end );
+    numFrames = ( file.tellg() - HEADER_SIZE ) / std::streamoff( buffer.size() * sizeof(float) );
+    return true;
+    
+}
+
+// Read the frame at a given index, from 0 to getNumFrames() - 1.
+//
+bool trajectoryReader::readFrame( const int &index, int &frame, spheCoord &camera, vector <ofVec3f> &positions ){
+    
+    if ( index < 0 || index >= numFrames ){ return false; }
+    
+    file.clear();
+    file.seekg( HEADER_SIZE + std::streamoff(index) * buffer.size() * sizeof(float) );
+    file.read( (char*)buffer.data(), buffer.size() * sizeof(float) );
+    if ( !file.good() ){ return false; }
+    
+    int32_t frameIndex;
+    memcpy( &frameIndex, buffer.data(), sizeof(frameIndex) );
+    frame = frameIndex;
+    camera = spheCoord( buffer[1], buffer[2], buffer[3] );
+    
+    positions.resize(numBoids);
+    for ( int i = 0; i < numBoids; i++ ){
+        positions[i].set( buffer[4 + 3*i], buffer[5 + 3*i], buffer[6 + 3*i] );
+    }
+    return true;
+    
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "ofMain.h"
+#include "spheCoord.h"
+#include <fstream>
+
+//========================================================================
+// Trajectory recording
+//========================================================================
+//
+// A trajectory file stores, for every recorded frame, the camera position
+// and the position of every boid ordered by id. Records have a fixed size,
+// such that any frame can be read directly without reading the others.
+//
+// File layout, in native byte order:
+//   header: "FLKT", uint32 version, uint32 number of boids, float edge length
+//   frame:  int32 frame, float radius, theta, phi, then float x, y, z per boid
+//
+
+//========================================================================
+// Trajectory writer class
+//========================================================================
+//
+class trajectoryWriter {
+    
+public:
+    
+    //--------------------------------------------------------------
+    // Public class destructor
+    //--------------------------------------------------------------
+    
+    ~trajectoryWriter();
+    
+    
+    //--------------------------------------------------------------
+    // Public member functions
+    //--------------------------------------------------------------
+    
+    bool open( const std::string &path, const int &numBoids, const double &edgeLength );
+    void close();
+    
+    bool isOpen(){ return file.is_open(); }
+    
+    void setPosition( const int &id, const ofVec3f &position );
+    void endFrame( const int &frame, const spheCoord &camera );
+    
+    
+private:
+    
+    //--------------------------------------------------------------
+    // Private member variables
+    //--------------------------------------------------------------
+    
+    std::ofstream file;
+    vector <float> positions;
+    
+};
+
+//========================================================================
+// Trajectory reader class
+//========================================================================
+//
+class trajectoryReader {
+    
+public:
+    
+    //--------------------------------------------------------------
+    // Public member functions
+    //--------------------------------------------------------------
+    
+    bool open( const std::string &path );
+    
+    int getNumBoids(){ return numBoids; }
+    int getNumFrames(){ return numFrames; }
+    double getEdgeLength(){ return edgeLength; }
+    
+    bool readFrame( const int &index, int &frame, spheCoord &camera, vector <ofVec3f> &positions );
+    
+    
+private:
+    
+    //--------------------------------------------------------------
+    // Private member variables
+    //--------------------------------------------------------------
+    
+    std::ifstream file;
+    int numBoids;
+    int numFrames;
+    double edgeLength;
+    vector <float> buffer;
+    
+};